@@ -0,0 +1,126 @@
+#include <coroutine>
+
+#include <doctest/doctest.h>
+#include <spdlog/spdlog.h>
+
+import miller.analysis;
+import miller.dialects;
+import miller.program;
+import miller.util;
+
+using namespace mi::imp;
+
+namespace mi::test
+{
+    //
+    // a = 1; b = a + 2; while (b < 10) { b = b + 1 }; c = a + 2
+    //
+    imp::program make_counter_program() {
+        return imp::program(
+            assign({"a"}, constant(1u)),
+            assign({"b"}, make_arithmetic< arithmetic_kind::add >(variable("a"), constant(2u))),
+            while_loop(
+                make_relational< predicate::lt >(variable("b"), constant(10u)),
+                assign({"b"}, make_arithmetic< arithmetic_kind::add >(variable("b"), constant(1u)))
+            ),
+            assign({"c"}, make_arithmetic< arithmetic_kind::add >(variable("a"), constant(2u)))
+        );
+    }
+
+    TEST_SUITE("mi::dfa::bitvector") {
+
+        TEST_CASE("flow graph of a loop") {
+            auto p = make_counter_program();
+            auto graph = dfa::build_flow_graph(p);
+
+            auto loop = graph.locations.at(p.body[2].self_label());
+            CHECK_EQ( graph.blocks[loop.block].items.size(), 1 );
+            CHECK_EQ( graph.blocks[loop.block].preds.size(), 2 );
+            CHECK_EQ( graph.blocks[loop.block].succs.size(), 2 );
+        }
+
+        TEST_CASE("consecutive unreachable statements share a block") {
+            imp::program p(
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    scope(
+                        terminate(),
+                        assign({"i"}, constant(1u)),
+                        skip(),
+                        break_iteration()
+                    )
+                )
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+
+            const auto &body = p.body[0].unwrap< while_loop >().body.unwrap< scope >();
+            auto dead = graph.locations.at(body[1].self_label()).block;
+            CHECK_EQ( graph.locations.at(body[2].self_label()).block, dead );
+            CHECK_EQ( graph.locations.at(body[3].self_label()).block, dead );
+            CHECK( graph.blocks[dead].preds.empty() );
+            CHECK_EQ( graph.blocks[dead].succs.size(), 1 );
+        }
+
+        TEST_CASE("liveness") {
+            auto p = make_counter_program();
+            auto graph = dfa::build_flow_graph(p);
+
+            dfa::liveness problem(graph);
+            auto result = dfa::solve(graph, problem);
+
+            auto a = *problem.variables.find("a");
+            auto b = *problem.variables.find("b");
+            auto c = *problem.variables.find("c");
+
+            auto at_loop = result.before_item(p.body[2].self_label());
+            CHECK( at_loop.test(a) );
+            CHECK( at_loop.test(b) );
+            CHECK( !at_loop.test(c) );
+
+            CHECK( result.before_item(p.body[0].self_label()).none() );
+            CHECK( result.after_item(p.body[3].self_label()).none() );
+        }
+
+        TEST_CASE("reaching definitions") {
+            auto p = make_counter_program();
+            auto graph = dfa::build_flow_graph(p);
+
+            dfa::reaching_definitions problem(graph);
+            auto result = dfa::solve(graph, problem);
+
+            const auto &loop = p.body[2].unwrap< while_loop >();
+            auto def = [&] (const auto &stmt) { return *problem.definitions.find(stmt.self_label()); };
+
+            auto at_c = result.before_item(p.body[3].self_label());
+            CHECK( at_c.test(def(p.body[0])) );
+            CHECK( at_c.test(def(p.body[1])) );
+            CHECK( at_c.test(def(loop.body)) );
+            CHECK_EQ( at_c.count(), 3 );
+        }
+
+        TEST_CASE("available expressions") {
+            auto p = make_counter_program();
+            auto graph = dfa::build_flow_graph(p);
+
+            dfa::available_expressions problem(graph);
+            auto result = dfa::solve(graph, problem);
+
+            auto a_plus_2 = *problem.index_of(
+                make_arithmetic< arithmetic_kind::add >(variable("a"), constant(2u))
+            );
+            auto b_plus_1 = *problem.index_of(
+                make_arithmetic< arithmetic_kind::add >(variable("b"), constant(1u))
+            );
+
+            auto at_loop = result.before_item(p.body[2].self_label());
+            CHECK( at_loop.test(a_plus_2) );
+            CHECK( !at_loop.test(b_plus_1) );
+
+            auto at_c = result.before_item(p.body[3].self_label());
+            CHECK( at_c.test(a_plus_2) );
+        }
+
+    } // test suite dfa bitvector
+
+} // namespace mi::test
@@ -0,0 +1,127 @@
+#include <coroutine>
+#include <string>
+
+#include <doctest/doctest.h>
+#include <spdlog/spdlog.h>
+
+#include "lattice.h"
+
+import miller.analysis;
+import miller.dialects;
+import miller.domains;
+import miller.program;
+import miller.util;
+
+using namespace mi::imp;
+
+namespace mi::test
+{
+    // taint as a chain: clean is 0, tainted is top
+    using taint = chain;
+
+    constexpr taint clean{ 0 };
+
+    auto taint_transfer = [] (const assign &stmt, auto read) {
+        auto result = clean;
+        for (const auto &var : read_variables(stmt.expr)) {
+            result = join(result, read(var.name));
+        }
+        return result;
+    };
+
+    TEST_SUITE("mi::dfa::sparse") {
+
+        TEST_CASE("straight-line def-use chains") {
+            imp::program p(
+                assign({"a"}, constant(1u)),
+                assign({"b"},
+                    make_arithmetic< arithmetic_kind::add >(variable("a"), constant(2u))
+                ),
+                assign({"c"},
+                    make_arithmetic< arithmetic_kind::mul >(variable("b"), variable("x"))
+                )
+            );
+
+            auto chains = dfa::build_def_use_chains(p);
+
+            auto a = p.body[0].self_label();
+            auto b = p.body[1].self_label();
+            auto c = p.body[2].self_label();
+
+            CHECK_EQ( chains.definitions.size(), 3 );
+            CHECK_EQ( chains.reaching(b, "a"), dfa::def_use_chains::def_set{ a } );
+            CHECK_EQ( chains.reaching(c, "b"), dfa::def_use_chains::def_set{ b } );
+            CHECK_EQ( chains.reaching(c, "x"), dfa::def_use_chains::def_set{ dfa::entry_definition } );
+
+            CHECK_EQ( chains.definitions.at(a).users, std::vector< label >{ b } );
+            CHECK( chains.definitions.at(c).users.empty() );
+        }
+
+        TEST_CASE("branches merge reaching definitions") {
+            imp::program p(
+                assign({"v"}, constant(0u)),
+                conditional(
+                    make_relational< predicate::eq >(variable("v"), constant(0u)),
+                    assign({"v"}, constant(1u)),
+                    skip()
+                ),
+                assign({"w"}, variable("v"))
+            );
+
+            auto chains = dfa::build_def_use_chains(p);
+
+            auto init = p.body[0].self_label();
+            const auto &cond = p.body[1].unwrap< conditional >();
+            auto then_def = cond.then_stmt.self_label();
+            auto w = p.body[2].self_label();
+
+            CHECK_EQ( chains.reaching(p.body[1].self_label(), "v"), dfa::def_use_chains::def_set{ init } );
+            CHECK_EQ( chains.reaching(w, "v"), dfa::def_use_chains::def_set{ init, then_def } );
+        }
+
+        TEST_CASE("loop carried definitions") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    assign({"i"}, make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u)))
+                )
+            );
+
+            auto chains = dfa::build_def_use_chains(p);
+
+            auto init = p.body[0].self_label();
+            const auto &loop = p.body[1].unwrap< while_loop >();
+            auto step = loop.body.self_label();
+
+            CHECK_EQ( chains.reaching(p.body[1].self_label(), "i"), dfa::def_use_chains::def_set{ init, step } );
+            CHECK_EQ( chains.reaching(step, "i"), dfa::def_use_chains::def_set{ init, step } );
+        }
+
+        TEST_CASE("sparse taint propagation") {
+            imp::program p(
+                assign({"a"}, constant(1u)),
+                assign({"b"},
+                    make_arithmetic< arithmetic_kind::add >(variable("a"), constant(2u))
+                ),
+                while_loop(
+                    make_relational< predicate::lt >(variable("b"), constant(10u)),
+                    assign({"b"}, make_arithmetic< arithmetic_kind::add >(variable("b"), variable("x")))
+                ),
+                assign({"c"}, variable("a"))
+            );
+
+            auto chains = dfa::build_def_use_chains(p);
+            auto result = dfa::sparse_fixpoint< taint >(chains, taint_transfer);
+
+            const auto &loop = p.body[2].unwrap< while_loop >();
+
+            CHECK_EQ( result.value_of(p.body[1].self_label()), clean );
+            CHECK_EQ( result.value_of(loop.body.self_label()), taint::top() );
+            CHECK_EQ( result.value_of(p.body[3].self_label()), clean );
+            CHECK_EQ( result.read(p.body[2].self_label(), "b"), taint::top() );
+        }
+
+    } // test suite dfa sparse
+
+} // namespace mi::test
@@ -1,22 +1,323 @@
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+#include <variant>
+
 #include <doctest/doctest.h>
 #include <spdlog/spdlog.h>
 
+#include "lattice.h"
+
 import miller.analysis;
 import miller.dialects;
+import miller.domains;
 import miller.program;
-import miller.sema;
 import miller.util;
 
 using namespace mi::imp;
 
 namespace mi::test
 {
+    // counts assignments since the last constant one; without widening
+    // the chain never stabilizes on loops
+    void count_assignments(const dfa::flow_item &item, chain &state) {
+        if (!item.assign || state.is_bottom()) {
+            return;
+        }
+
+        auto aexpr = std::get_if< aexpr_t >(&item.assign->expr);
+        if (aexpr && std::holds_alternative< constant >(*aexpr)) {
+            state = { 0 };
+        } else if (!state.is_top()) {
+            ++state.value;
+        }
+    }
+
+    // `x := x + x` repeated once per index
+    template< std::size_t... idx >
+    imp::program doubling_chain(std::index_sequence< idx... >) {
+        auto doubling = [] (std::size_t) {
+            return assign({"x"}, make_arithmetic< arithmetic_kind::add >(variable("x"), variable("x")));
+        };
+        return imp::program(doubling(idx)...);
+    }
+
     TEST_SUITE("mi::analysis::forward") {
 
         TEST_CASE("empty init") {
 
         }
 
+        TEST_CASE("invariants stored at cut points") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                assign({"j"}, constant(0u)),
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    scope(
+                        assign({"i"}, make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u))),
+                        assign({"j"}, variable("i"))
+                    )
+                ),
+                skip()
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+
+            unsigned transfers = 0;
+            auto transfer = [&] (const dfa::flow_item &, chain &) { ++transfers; };
+
+            auto result = analysis::forward_fixpoint< chain >(
+                graph, transfer, { .cache_capacity = 2 }
+            );
+
+            // one state per block: the entry with both initial assigns, the
+            // loop head, the loop body, the block after the loop and the exit
+            CHECK_EQ( graph.size(), 5 );
+            CHECK_EQ( result.stored(), 5 );
+            CHECK( result.stored() < graph.locations.size() );
+
+            auto dense = result.materialize();
+            CHECK_EQ( dense.pre.size(), graph.locations.size() );
+            CHECK_EQ( dense.post.size(), graph.locations.size() );
+
+            const auto &body = p.body[2].unwrap< while_loop >().body.unwrap< scope >();
+            auto last = body.back().self_label();
+
+            transfers = 0;
+            CHECK_EQ( result.pre(last), chain::top() );
+            CHECK_EQ( transfers, 1 );
+
+            // cached query does not replay
+            transfers = 0;
+            CHECK_EQ( result.pre(last), chain::top() );
+            CHECK_EQ( transfers, 0 );
+        }
+
+        TEST_CASE("demand-driven query solves only the backward slice") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    assign({"i"}, make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u)))
+                ),
+                while_loop(
+                    make_relational< predicate::gt >(variable("i"), constant(0u)),
+                    assign({"i"}, make_arithmetic< arithmetic_kind::sub >(variable("i"), constant(1u)))
+                )
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+            auto transfer = [] (const dfa::flow_item &, domains::unit &) {};
+
+            analysis::demand_analysis< domains::unit, decltype(transfer) > analysis(graph, transfer);
+
+            const auto &first = p.body[1].unwrap< while_loop >();
+            CHECK_EQ( analysis.invariant_at(first.body.self_label()), domains::unit{} );
+
+            auto partial = analysis.solved_blocks();
+            CHECK( partial < graph.size() );
+
+            const auto &second = p.body[2].unwrap< while_loop >();
+            CHECK_EQ( analysis.invariant_at(second.body.self_label()), domains::unit{} );
+            CHECK( analysis.solved_blocks() > partial );
+            CHECK( !analysis.is_solved(dfa::flow_graph::exit) );
+        }
+
+        TEST_CASE("exhausted budget truncates unfinished blocks to top") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    assign({"i"}, make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u)))
+                ),
+                skip()
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+
+            analysis::fixpoint_options options;
+            options.budget.max_steps = 16;
+            options.budget.widening_steps = 8;
+
+            auto result = analysis::forward_fixpoint< chain >(graph, count_assignments, options);
+
+            const auto &status = result.status();
+            CHECK( !status.complete() );
+            CHECK( status.exhausted == analysis::budget_kind::steps );
+            CHECK( status.truncated.count() > 0 );
+
+            const auto &loop = p.body[1].unwrap< while_loop >();
+            CHECK( result.is_truncated(loop.body.self_label()) );
+            CHECK( result.pre(loop.body.self_label()).is_top() );
+
+            // the program entry is finished before the budget runs out
+            CHECK( !result.is_truncated(p.body[0].self_label()) );
+            CHECK( result.materialize().truncated.contains(loop.body.self_label()) );
+        }
+
+        TEST_CASE("statements without effect have invariants") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                skip(),
+                while_loop(
+                    make_relational< predicate::lt >(variable("i"), constant(10u)),
+                    scope(
+                        assign({"i"}, make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u))),
+                        break_iteration(),
+                        skip()
+                    )
+                ),
+                terminate(),
+                skip()
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+
+            auto result = analysis::forward_fixpoint< chain >(graph, count_assignments);
+
+            const auto &body = p.body[2].unwrap< while_loop >().body.unwrap< scope >();
+            CHECK_EQ( result.pre(p.body[1].self_label()), chain{ 0 } );
+            CHECK_EQ( result.post(p.body[1].self_label()), chain{ 0 } );
+            CHECK_EQ( result.pre(body[1].self_label()), chain{ 1 } );
+            CHECK_EQ( result.pre(p.body[3].self_label()), chain{ 1 } );
+
+            // statements after a break or terminate are unreachable
+            CHECK( result.pre(body[2].self_label()).is_bottom() );
+            CHECK( result.pre(body.self_label()).is_bottom() );
+            CHECK( result.pre(p.body[4].self_label()).is_bottom() );
+            CHECK( result.pre(p.self_label()).is_bottom() );
+
+            auto dense = result.materialize();
+            CHECK( dense.pre.contains(p.body[1].self_label()) );
+            CHECK( dense.post.contains(body[1].self_label()) );
+            CHECK( dense.pre.contains(p.self_label()) );
+        }
+
+        TEST_CASE("unbounded fixpoint is complete") {
+            imp::program p(
+                assign({"i"}, constant(0u)),
+                skip()
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+            auto transfer = [] (const dfa::flow_item &, domains::unit &) {};
+
+            auto result = analysis::forward_fixpoint< domains::unit >(graph, transfer);
+            CHECK( result.status().complete() );
+            CHECK( result.status().truncated.none() );
+        }
+
+        TEST_CASE("loop body applied as one block summary") {
+            imp::program p(
+                assign({"a"}, constant(0u)),
+                assign({"b"}, constant(0u)),
+                while_loop(
+                    make_relational< predicate::lt >(variable("a"), constant(10u)),
+                    scope(
+                        assign({"a"}, make_arithmetic< arithmetic_kind::add >(variable("b"), constant(1u))),
+                        assign({"b"}, make_arithmetic< arithmetic_kind::mul >(variable("a"), constant(2u))),
+                        assign({"a"}, make_arithmetic< arithmetic_kind::sub >(variable("a"), variable("b")))
+                    )
+                )
+            );
+
+            auto graph = dfa::build_flow_graph(p);
+            auto summaries = dfa::summarize(graph);
+
+            const auto &loop = p.body[2].unwrap< while_loop >();
+            auto body = graph.locations.at(loop.body.unwrap< scope >().front().self_label()).block;
+
+            const auto &summary = summaries[body];
+            CHECK_EQ( summary.items, 3 );
+            REQUIRE_EQ( summary.updates.size(), 2 );
+
+            const auto &dag = summaries.dag;
+            CHECK_EQ( summary.updates[0].first, "a" );
+            CHECK_EQ( dag.to_string(summary.updates[0].second), "((b + 1) - ((b + 1) * 2))" );
+            CHECK_EQ( summary.updates[1].first, "b" );
+            CHECK_EQ( dag.to_string(summary.updates[1].second), "((b + 1) * 2)" );
+
+            unsigned summaries_applied = 0, items_applied = 0;
+            auto transfer = dfa::summarize_transfer< chain >(
+                summaries,
+                [&] (const imp::expression_dag &, const dfa::parallel_assignment &, chain &) {
+                    ++summaries_applied;
+                },
+                [&] (const dfa::flow_item &, chain &) { ++items_applied; }
+            );
+
+            auto result = analysis::forward_fixpoint< chain >(graph, transfer);
+            CHECK( summaries_applied > 0 );
+            CHECK_EQ( items_applied, 0 );
+
+            // queries inside the block replay items from the stored entry
+            CHECK_EQ( result.post(loop.body.unwrap< scope >().back().self_label()), chain::top() );
+            CHECK_EQ( items_applied, 3 );
+        }
+
+        TEST_CASE("self-referential chain is summarized and evaluated linearly") {
+            constexpr std::size_t length = 63;
+            auto p = doubling_chain(std::make_index_sequence< length >{});
+
+            auto graph = dfa::build_flow_graph(p);
+            auto summaries = dfa::summarize(graph);
+
+            auto block = graph.locations.at(p.front().self_label()).block;
+            const auto &summary = summaries[block];
+            CHECK_EQ( summary.items, length );
+            REQUIRE_EQ( summary.updates.size(), 1 );
+
+            // the value of x unfolds to 2^63 leaves over x and one sum per assign
+            CHECK_EQ( summary.order.size(), length + 1 );
+            CHECK_EQ( summary.order.back(), summary.updates[0].second );
+
+            unsigned evaluated = 0;
+            auto leaves = [&] (imp::expr_id, const imp::expr_node &node, const dfa::node_values< std::uint64_t > &operands) {
+                ++evaluated;
+                return node.is_binary() ? operands.at(node.lhs) + operands.at(node.rhs) : std::uint64_t(1);
+            };
+
+            auto values = dfa::evaluate_summary< std::uint64_t >(summaries.dag, summary, leaves);
+            CHECK_EQ( evaluated, length + 1 );
+            CHECK_EQ( values.at(summary.updates[0].second), std::uint64_t(1) << length );
+
+            // every application of the summary evaluates each node once
+            evaluated = 0;
+            unsigned applied = 0;
+            auto transfer = dfa::summarize_transfer< chain >(
+                summaries,
+                [&] (const imp::expression_dag &dag, const dfa::parallel_assignment &assignment, chain &) {
+                    ++applied;
+                    dfa::evaluate_summary< std::uint64_t >(dag, assignment, leaves);
+                },
+                [] (const dfa::flow_item &, chain &) {}
+            );
+
+            analysis::forward_fixpoint< chain >(graph, transfer);
+            CHECK( applied > 0 );
+            CHECK_EQ( evaluated, applied * (length + 1) );
+
+            // with a memo each node is evaluated once per entry state
+            evaluated = 0;
+            applied = 0;
+            dfa::evaluation_memo< chain, std::uint64_t > memo;
+            auto memoized = dfa::summarize_transfer< chain >(
+                summaries,
+                [&] (const imp::expression_dag &dag, const dfa::parallel_assignment &assignment, chain &state) {
+                    ++applied;
+                    dfa::evaluate_summary< std::uint64_t >(dag, assignment, state, memo, leaves);
+                },
+                [] (const dfa::flow_item &, chain &) {}
+            );
+
+            analysis::forward_fixpoint< chain >(graph, memoized);
+            analysis::forward_fixpoint< chain >(graph, memoized);
+            CHECK( applied > 1 );
+            CHECK_EQ( evaluated, length + 1 );
+            CHECK_EQ( memo.size(), length + 1 );
+        }
+
     } // test suite analysis forward
 
 } // namespace mi::test
@@ -0,0 +1,78 @@
+#include <coroutine>
+#include <iterator>
+#include <set>
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/MLIRContext.h>
+#include <mlir/Parser/Parser.h>
+
+import miller.analysis;
+import miller.dialects;
+import miller.domains;
+import miller.program;
+
+namespace mi::test
+{
+    constexpr const char *unreachable_source = R"(
+        "test.func"() ({
+          ^bb0:
+            "test.op"() : () -> ()
+            "test.br"()[^bb2] : () -> ()
+          ^bb1:
+            "test.dead"() : () -> ()
+            "test.br"()[^bb2] : () -> ()
+          ^bb2:
+            "test.return"() : () -> ()
+        }) : () -> ()
+    )";
+
+    TEST_SUITE("mi::analysis::mlir") {
+
+        TEST_CASE("module analysed in place") {
+            mlir::MLIRContext ctx;
+            ctx.allowUnregisteredDialects();
+
+            auto mod = mlir::parseSourceString< mlir::ModuleOp >(
+                unreachable_source, mlir::ParserConfig(&ctx)
+            );
+            REQUIRE( mod );
+
+            auto graph = dfa::build_flow_graph(dyn::operation_view{ mod->getOperation() });
+
+            std::set< std::string > visited;
+            auto transfer = [&] (const dfa::flow_item &item, domains::reachability &) {
+                if (item.operation) {
+                    visited.emplace(item.operation->name());
+                }
+            };
+
+            auto result = analysis::forward_fixpoint< domains::reachability >(graph, transfer);
+            CHECK( result.status().complete() );
+
+            auto &region = mod->getBody()->front().getRegion(0);
+            auto &entry = region.front();
+            auto &dead = *std::next(region.begin());
+            auto &exit = region.back();
+
+            CHECK( result.pre(self_entry_label(entry.front())).is_top() );
+            CHECK( result.pre(self_entry_label(exit.front())).is_top() );
+            CHECK( result.pre(self_entry_label(dead.front())).is_bottom() );
+            CHECK( result.post(self_entry_label(dead)).is_bottom() );
+
+            // the region exit is reached after the return
+            CHECK( result.pre(self_entry_label(region)).is_top() );
+
+            auto dense = result.materialize();
+            CHECK( !dense.pre.empty() );
+            CHECK_EQ( dense.pre.size(), graph.locations.size() );
+            CHECK( visited.contains("test.op") );
+
+            // the transfer never runs on the bottom state of the dead block
+            CHECK_FALSE( visited.contains("test.dead") );
+        }
+    }
+
+} // namespace mi::test
@@ -0,0 +1,57 @@
+#include <coroutine>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+import miller.dialects;
+import miller.util;
+
+using namespace mi::imp;
+
+namespace mi::test
+{
+    TEST_SUITE("mi::imp::expression_dag") {
+        TEST_CASE("identical subexpressions share nodes") {
+            expression_dag dag;
+
+            auto i_plus_1 = [] {
+                return make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u));
+            };
+
+            auto lhs = dag.intern(i_plus_1());
+            auto rhs = dag.intern(make_arithmetic< arithmetic_kind::mul >(i_plus_1(), i_plus_1()));
+
+            CHECK_EQ( dag[rhs].lhs, lhs );
+            CHECK_EQ( dag[rhs].rhs, lhs );
+
+            // i, 1, i + 1 and the product
+            CHECK_EQ( dag.size(), 4 );
+            CHECK_EQ( dag.find(i_plus_1()), std::optional< expr_id >(lhs) );
+            CHECK_EQ( dag.to_string(rhs), "((i + 1) * (i + 1))" );
+        }
+
+        TEST_CASE("subexpressions and variables of a condition") {
+            expression_dag dag;
+
+            auto cond = dag.intern(bexpr_t(make_relational< predicate::lt >(
+                make_arithmetic< arithmetic_kind::add >(variable("a"), variable("b")), constant(10u)
+            )));
+
+            std::vector< std::string > vars;
+            for (auto var : dag.variables(cond)) {
+                vars.push_back(dag.name_of(var));
+            }
+            CHECK_EQ( vars, std::vector< std::string >{ "a", "b" } );
+
+            std::vector< expr_id > subexprs;
+            for (auto expr : dag.arithmetic_subexpressions(cond)) {
+                subexprs.push_back(expr);
+            }
+            CHECK_EQ( subexprs.size(), 1 );
+            CHECK_EQ( dag.to_string(subexprs.front()), "(a + b)" );
+        }
+    }
+
+} // namespace mi::test
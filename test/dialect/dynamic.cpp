@@ -0,0 +1,71 @@
+#include <coroutine>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <spdlog/spdlog.h>
+
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/MLIRContext.h>
+#include <mlir/Parser/Parser.h>
+
+import miller.dialects;
+import miller.program;
+import miller.util;
+
+namespace mi::test
+{
+    constexpr const char *module_source = R"(
+        "test.func"() ({
+          ^bb0:
+            "test.op"() : () -> ()
+            "test.br"()[^bb1] : () -> ()
+          ^bb1:
+            "test.return"() : () -> ()
+        }) : () -> ()
+    )";
+
+    TEST_SUITE("mi::dyn") {
+        TEST_CASE("views of mlir operations") {
+            mlir::MLIRContext ctx;
+            ctx.allowUnregisteredDialects();
+
+            auto mod = mlir::parseSourceString< mlir::ModuleOp >(
+                module_source, mlir::ParserConfig(&ctx)
+            );
+            REQUIRE( mod );
+
+            auto &func = mod->getBody()->front();
+            dyn::operation_view view{ &func };
+
+            CHECK( view.has_internal_scope() );
+            CHECK_EQ( view.entry(), self_entry_label(func) );
+
+            auto &region = func.getRegion(0);
+            auto &first = region.front();
+            auto &second = *std::next(region.begin());
+
+            dyn::block_view entry_block{ &first };
+            CHECK_EQ( entry_block.entry(), self_entry_label(first.front()) );
+
+            std::vector< label > succs;
+            for (auto succ : dyn::block_view{ &first }.successors()) {
+                succs.push_back(succ);
+            }
+            CHECK_EQ( succs, std::vector< label >{ self_entry_label(second.front()) } );
+
+            // labels are the ir objects themselves, no copy of the module
+            std::vector< label > internal;
+            for (auto lab : view.internal_labels()) {
+                internal.push_back(lab);
+            }
+            CHECK_EQ( internal.size(), 6 );
+
+            operation wrapped{ dyn::operation_view{ &func } };
+            CHECK_EQ( wrapped.exit_of(operation(dyn::operation_view{ &first.front() })),
+                      std::optional< label >(self_entry_label(first.back())) );
+        }
+    }
+
+} // namespace mi::test
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <doctest/doctest.h>
+#include <fmt/format.h>
 #include <refl.hpp>
 #include <spdlog/spdlog.h>
 
@@ -281,6 +282,75 @@ namespace mi::test
             CHECK( !inner.escape() );
         }
 
+        TEST_CASE("format nested program") {
+            imp::program p(
+                assign({"v"}, constant(1u)),
+                while_loop(
+                    make_relational< predicate::gt >(variable("v"),  constant(0u)),
+                    conditional(
+                        make_relational< predicate::eq >(variable("v"),  constant(0u)),
+                        break_iteration(),
+                        skip()
+                    )
+                )
+            );
+
+            auto repr = p.format();
+            CHECK_EQ( repr, fmt::format("{}", p) );
+            CHECK_THROWS_AS( fmt::format(fmt::runtime("{:>80}"), p), fmt::format_error );
+
+            CHECK( repr.starts_with("{\n") );
+            CHECK( repr.ends_with("}\n") );
+            CHECK( repr.find("while : ") != std::string::npos );
+            CHECK( repr.find("then : ") != std::string::npos );
+            CHECK( repr.find("skip : ") != std::string::npos );
+        }
+
+        TEST_CASE("copied expressions share operands") {
+            aexpr_t expr = make_arithmetic< arithmetic_kind::mul >(
+                make_arithmetic< arithmetic_kind::add >(variable("i"), constant(1u)),
+                variable("j")
+            );
+
+            auto copy = expr;
+            const auto &original = std::get< arithmetic_binary >(expr);
+            const auto &copied = std::get< arithmetic_binary >(copy);
+
+            CHECK_EQ( &*original.lhs, &*copied.lhs );
+            CHECK_EQ( &*original.rhs, &*copied.rhs );
+
+            // statements take a copy of the expression, not of its operands
+            assign stmt({"k"}, expr);
+            const auto &value = std::get< arithmetic_binary >(std::get< aexpr_t >(stmt.expr));
+            CHECK_EQ( &*value.lhs, &*original.lhs );
+        }
+
+        TEST_CASE("equal expressions built separately share nodes") {
+            auto before = box< aexpr_t >::interned();
+
+            auto n_plus_1 = [] {
+                return make_arithmetic< arithmetic_kind::add >(variable("shared_n"), constant(41u));
+            };
+
+            aexpr_t square = make_arithmetic< arithmetic_kind::mul >(n_plus_1(), n_plus_1());
+            aexpr_t again  = make_arithmetic< arithmetic_kind::mul >(n_plus_1(), n_plus_1());
+
+            // shared_n, 41 and one shared_n + 41 for all four operands
+            CHECK_EQ( box< aexpr_t >::interned() - before, 3 );
+
+            const auto &lhs = std::get< arithmetic_binary >(square);
+            const auto &rhs = std::get< arithmetic_binary >(again);
+            CHECK_EQ( lhs.lhs.id(), lhs.rhs.id() );
+            CHECK_EQ( lhs.lhs.id(), rhs.lhs.id() );
+
+            CHECK( square == again );
+            CHECK_EQ( square.hash(), again.hash() );
+            CHECK( square != aexpr_t(make_arithmetic< arithmetic_kind::mul >(n_plus_1(), constant(2u))) );
+
+            bexpr_t cond = make_relational< predicate::lt >(variable("shared_n"), constant(41u));
+            CHECK( cond == bexpr_t(make_relational< predicate::lt >(variable("shared_n"), constant(41u))) );
+        }
+
         static_assert( operation_like< imp::program > );
         static_assert( operation_like< imp::while_loop > );
         static_assert( operation_like< imp::conditional > );
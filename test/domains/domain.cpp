@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include "lattice.h"
+
+import miller.domains;
+
+namespace mi::test
+{
+    // the shared chain with and without in-place members
+    using in_place_probe = basic_chain< true >;
+    using value_probe    = basic_chain< false >;
+
+    static_assert(domains::domain_like< in_place_probe >);
+    static_assert(domains::domain_like< value_probe >);
+
+    static_assert(domains::has_join_with< in_place_probe >);
+    static_assert(!domains::has_join_with< value_probe >);
+    static_assert(!domains::has_widen< value_probe >);
+
+    TEST_SUITE("mi::domains::domain") {
+
+        TEST_CASE("in-place operations are preferred") {
+            chain_calls::reset();
+
+            in_place_probe value{ 3 };
+            CHECK(domains::join_into(value, in_place_probe{ 5 }));
+            CHECK_EQ(value.value, 5);
+            CHECK_FALSE(domains::join_into(value, in_place_probe{ 2 }));
+
+            CHECK(domains::meet_into(value, in_place_probe{ 4 }));
+            CHECK_EQ(value.value, 4);
+
+            CHECK(domains::widen_into(value, in_place_probe{ 7 }));
+            CHECK(value.is_top());
+
+            CHECK(domains::is_leq(in_place_probe{ 1 }, value));
+
+            CHECK_EQ(chain_calls::in_place, 5);
+            CHECK_EQ(chain_calls::by_value, 0);
+        }
+
+        TEST_CASE("value forms are used without in-place members") {
+            chain_calls::reset();
+
+            value_probe value{ 3 };
+            CHECK(domains::join_into(value, value_probe{ 5 }));
+            CHECK_EQ(value.value, 5);
+            CHECK_FALSE(domains::join_into(value, value_probe{ 2 }));
+
+            CHECK(domains::meet_into(value, value_probe{ 4 }));
+            CHECK_EQ(value.value, 4);
+
+            CHECK_EQ(chain_calls::by_value, 3);
+            CHECK_EQ(chain_calls::in_place, 0);
+        }
+
+        TEST_CASE("widening falls back to join for finite domains") {
+            chain_calls::reset();
+
+            value_probe value{ 3 };
+            CHECK(domains::widen_into(value, value_probe{ 7 }));
+            CHECK_EQ(value.value, 7);
+            CHECK_EQ(chain_calls::by_value, 1);
+        }
+
+        TEST_CASE("order by join without leq") {
+            chain_calls::reset();
+
+            CHECK(domains::is_leq(value_probe{ 1 }, value_probe{ 2 }));
+            CHECK_FALSE(domains::is_leq(value_probe{ 2 }, value_probe{ 1 }));
+            CHECK_EQ(chain_calls::by_value, 2);
+        }
+    }
+
+} // namespace mi::test
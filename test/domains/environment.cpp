@@ -0,0 +1,145 @@
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include <doctest/doctest.h>
+
+import miller.domains;
+
+namespace mi::test
+{
+    //
+    // flat lattice of integer constants: bottom < n < top
+    //
+    struct flat {
+        enum class kind { bottom, constant, top };
+
+        kind state;
+        int value = 0;
+
+        static constexpr domains::domain_info info() noexcept { return {}; }
+
+        static constexpr flat top() noexcept { return { kind::top }; }
+        static constexpr flat bottom() noexcept { return { kind::bottom }; }
+        static constexpr flat of(int value) noexcept { return { kind::constant, value }; }
+
+        constexpr bool is_top() const noexcept { return state == kind::top; }
+        constexpr bool is_bottom() const noexcept { return state == kind::bottom; }
+
+        constexpr bool operator==(const flat &) const = default;
+
+        std::size_t hash() const noexcept { return std::size_t(state) * 31 + std::size_t(value); }
+    };
+
+    constexpr flat join(flat a, flat b) noexcept {
+        if (a.is_bottom() || a == b) {
+            return b;
+        }
+        return b.is_bottom() ? a : flat::top();
+    }
+
+    constexpr flat meet(flat a, flat b) noexcept {
+        if (a.is_top() || a == b) {
+            return b;
+        }
+        return b.is_top() ? a : flat::bottom();
+    }
+
+    using env = domains::environment< std::string, flat >;
+
+    static_assert(domains::domain_like< env >);
+
+    env make_env(std::initializer_list< std::pair< std::string, flat > > values) {
+        env result;
+        for (const auto &[var, value] : values) {
+            result[var] = value;
+        }
+        return result;
+    }
+
+    TEST_SUITE("mi::domains::environment") {
+
+        TEST_CASE("top and bottom") {
+            CHECK(env::top().is_top());
+            CHECK_FALSE(env::top().is_bottom());
+
+            CHECK(env::bottom().is_bottom());
+            CHECK_FALSE(env::bottom().is_top());
+            CHECK_EQ(env::bottom().size(), 0);
+
+            CHECK(make_env({ { "x", flat::top() } }).is_top());
+            CHECK_FALSE(make_env({ { "x", flat::of(1) } }).is_top());
+
+            CHECK(domains::is_leq(env::bottom(), env::top()));
+            CHECK_FALSE(domains::is_leq(env::top(), env::bottom()));
+        }
+
+        TEST_CASE("missing variables are unconstrained") {
+            auto x = make_env({ { "x", flat::of(1) } });
+            auto y = make_env({ { "y", flat::of(2) } });
+
+            CHECK(domains::is_leq(x, env::top()));
+            CHECK_FALSE(domains::is_leq(env::top(), x));
+            CHECK_EQ(make_env({ { "x", flat::top() } }), env::top());
+            CHECK_EQ(
+                domains::hash_value(make_env({ { "x", flat::top() } })),
+                domains::hash_value(env::top())
+            );
+
+            // join keeps only variables constrained on both sides
+            CHECK(join(x, y).is_top());
+
+            // meet keeps the constraints of both
+            auto both = meet(x, y);
+            CHECK_EQ(both.size(), 2);
+            CHECK_EQ(both["x"], flat::of(1));
+            CHECK_EQ(both["y"], flat::of(2));
+            CHECK(domains::is_leq(both, x));
+            CHECK(domains::is_leq(both, y));
+        }
+
+        TEST_CASE("conflicting meet collapses to bottom") {
+            auto one = make_env({ { "x", flat::of(1) }, { "y", flat::of(0) } });
+            auto two = make_env({ { "x", flat::of(2) } });
+
+            auto result = meet(one, two);
+            CHECK(result.is_bottom());
+            CHECK_EQ(result.size(), 0);
+            CHECK_EQ(result, env::bottom());
+        }
+
+        TEST_CASE("in-place operations report changes") {
+            auto x = make_env({ { "x", flat::of(1) } });
+
+            auto value = x;
+            CHECK_FALSE(value.join_with(x));
+            CHECK_FALSE(value.join_with(env::bottom()));
+            CHECK_FALSE(value.meet_with(env::top()));
+
+            CHECK(value.join_with(make_env({ { "x", flat::of(2) } })));
+            CHECK(value.is_top());
+
+            auto unreachable = env::bottom();
+            CHECK(unreachable.join_with(x));
+            CHECK_EQ(unreachable, x);
+
+            // unconstrained variables of the other side are no change
+            auto constrained = x;
+            CHECK_FALSE(constrained.meet_with(make_env({ { "x", flat::top() }, { "y", flat::top() } })));
+            CHECK_FALSE(constrained.meet_with(x));
+            CHECK_EQ(constrained.size(), 1);
+            CHECK(constrained.meet_with(make_env({ { "y", flat::of(2) } })));
+            CHECK_FALSE(constrained.meet_with(make_env({ { "y", flat::of(2) } })));
+
+            CHECK(unreachable.meet_with(env::bottom()));
+            CHECK(unreachable.is_bottom());
+            CHECK_FALSE(unreachable.meet_with(x));
+
+            auto widened = x;
+            CHECK(domains::widen_into(widened, make_env({ { "x", flat::of(3) } })));
+            CHECK(widened.is_top());
+        }
+    }
+
+} // namespace mi::test
@@ -0,0 +1,112 @@
+#include <string>
+
+#include <doctest/doctest.h>
+
+#include "lattice.h"
+
+import miller.domains;
+
+namespace mi::test
+{
+    using env = domains::environment< std::string, chain >;
+    using state = domains::hash_consed< env >;
+
+    static_assert(domains::domain_like< state >);
+    static_assert(domains::domain_like< domains::hash_consed< chain, false > >);
+
+    env make_state(int x, int y) {
+        env result;
+        result["x"] = { x };
+        result["y"] = { y };
+        return result;
+    }
+
+    TEST_SUITE("mi::domains::hash_consed") {
+
+        TEST_CASE("equal values share the canonical copy") {
+            state::context ctx;
+
+            state a(ctx, make_state(1, 2));
+            state b(ctx, make_state(1, 2));
+            state c(ctx, make_state(2, 2));
+
+            CHECK_EQ(a, b);
+            CHECK_EQ(&*a, &*b);
+            CHECK_NE(a, c);
+            CHECK_EQ(ctx.size(), 2);
+
+            // values equal to top or bottom are the static canonical copies
+            CHECK_EQ(state(ctx, env::top()), state::top());
+            CHECK_EQ(state(ctx, env::bottom()), state::bottom());
+            CHECK_EQ(state(), state::top());
+            CHECK_EQ(ctx.size(), 2);
+        }
+
+        TEST_CASE("environment hash agrees with equality") {
+            state::context ctx;
+
+            // unconstrained variables neither change equality nor the hash
+            auto constrained = make_state(1, chain::top_value);
+            env same;
+            same["x"] = { 1 };
+
+            CHECK_EQ(constrained, same);
+            CHECK_EQ(domains::hash_value(constrained), domains::hash_value(same));
+            CHECK_EQ(state(ctx, constrained), state(ctx, same));
+            CHECK_EQ(ctx.size(), 1);
+
+            CHECK_EQ(state(ctx, make_state(chain::top_value, chain::top_value)), state::top());
+        }
+
+        TEST_CASE("operations on identical handles are not computed") {
+            state::context ctx;
+            state a(ctx, make_state(1, 2));
+
+            chain_calls::reset();
+            CHECK_EQ(join(a, a), a);
+            CHECK_EQ(widen(a, a), a);
+            CHECK_FALSE(a.join_with(a));
+            CHECK_EQ(chain_calls::by_value, 0);
+        }
+
+        TEST_CASE("results are memoized per handle pair") {
+            state::context ctx;
+            state a(ctx, make_state(1, 2));
+            state b(ctx, make_state(3, 1));
+
+            chain_calls::reset();
+            auto joined = join(a, b);
+            CHECK_EQ(*joined, make_state(3, 2));
+            auto computed = chain_calls::by_value;
+            CHECK(computed > 0);
+
+            // join is commutative, the swapped pair hits the memo
+            CHECK_EQ(join(b, a), joined);
+            CHECK_EQ(join(a, b), joined);
+            CHECK_EQ(chain_calls::by_value, computed);
+
+            auto value = a;
+            CHECK(value.join_with(b));
+            CHECK_EQ(value, joined);
+            CHECK_EQ(chain_calls::by_value, computed);
+
+            // the same values in another context are computed again
+            state::context other;
+            CHECK_EQ(*join(state(other, make_state(1, 2)), state(other, make_state(3, 1))), *joined);
+            CHECK(chain_calls::by_value > computed);
+        }
+
+        TEST_CASE("top and bottom work without a context") {
+            CHECK_EQ(join(state::top(), state::bottom()), state::top());
+            CHECK_EQ(meet(state::top(), state::bottom()), state::bottom());
+
+            state::context ctx;
+            state a(ctx, make_state(1, 2));
+            CHECK_EQ(join(state::bottom(), a), a);
+            CHECK_EQ(meet(state::top(), a), a);
+            CHECK(domains::is_leq(state::bottom(), a));
+            CHECK(domains::is_leq(a, state::top()));
+        }
+    }
+
+} // namespace mi::test
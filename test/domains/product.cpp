@@ -0,0 +1,165 @@
+#include <doctest/doctest.h>
+
+#include "lattice.h"
+
+import miller.domains;
+
+namespace mi::test
+{
+    //
+    // parity: bottom < even, odd < top
+    //
+    struct parity {
+        enum class kind { bottom, even, odd, top };
+
+        kind value;
+
+        static constexpr domains::domain_info info() noexcept { return {}; }
+
+        static constexpr parity top() noexcept { return { kind::top }; }
+        static constexpr parity bottom() noexcept { return { kind::bottom }; }
+
+        constexpr bool is_top() const noexcept { return value == kind::top; }
+        constexpr bool is_bottom() const noexcept { return value == kind::bottom; }
+
+        constexpr bool operator==(const parity &) const = default;
+    };
+
+    constexpr parity join(parity a, parity b) noexcept {
+        if (a.is_bottom() || a == b) {
+            return b;
+        }
+        return b.is_bottom() ? a : parity::top();
+    }
+
+    constexpr parity meet(parity a, parity b) noexcept {
+        if (a.is_top() || a == b) {
+            return b;
+        }
+        return b.is_top() ? a : parity::bottom();
+    }
+
+    static int reductions = 0;
+
+    // the chain is an upper bound of the value, the only value bounded by
+    // zero is even
+    bool reduce(parity &refined, const chain &by) {
+        ++reductions;
+        if (by.value != 0) {
+            return false;
+        }
+        return domains::meet_into(refined, parity{ parity::kind::even });
+    }
+
+    // an upper bound of the other parity is not reached
+    bool reduce(chain &refined, const parity &by) {
+        ++reductions;
+        if (refined.is_bottom() || refined.is_top()) {
+            return false;
+        }
+
+        bool odd = refined.value % 2 != 0;
+        if ((by.value == parity::kind::even && odd) || (by.value == parity::kind::odd && !odd)) {
+            --refined.value;
+            return true;
+        }
+        return false;
+    }
+
+    using bounded_parity = domains::product< parity, chain >;
+
+    static_assert(domains::domain_like< bounded_parity >);
+    static_assert(domains::reducible_with< parity, chain >);
+    static_assert(domains::reducible_with< chain, parity >);
+
+    constexpr bounded_parity make(parity::kind p, int b) { return { { parity{ p }, chain{ b } } }; }
+
+    TEST_SUITE("mi::domains::product") {
+
+        TEST_CASE("componentwise join and meet") {
+            auto a = make(parity::kind::even, 4);
+            auto b = make(parity::kind::odd, 7);
+
+            auto joined = join(a, b);
+            CHECK(joined.get< parity >().is_top());
+            CHECK_EQ(joined.get< chain >().value, 7);
+
+            auto top_parity = make(parity::kind::top, 9);
+            auto met = meet(b, top_parity);
+            CHECK_EQ(met.get< parity >().value, parity::kind::odd);
+            CHECK_EQ(met.get< chain >().value, 7);
+
+            CHECK_EQ(join(a, bounded_parity::bottom()), a);
+            CHECK_EQ(meet(a, bounded_parity::top()), a);
+        }
+
+        TEST_CASE("strictly bottom component collapses the product") {
+            auto met = meet(make(parity::kind::even, 3), make(parity::kind::odd, 5));
+            CHECK(met.is_bottom());
+            CHECK(met.get< chain >().is_bottom());
+
+            auto value = make(parity::kind::top, 5);
+            CHECK(value.meet_with(make(parity::kind::top, -1)));
+            CHECK(value.is_bottom());
+            CHECK_EQ(value, bounded_parity::bottom());
+        }
+
+        TEST_CASE("product with a strictly bottom component is bottom") {
+            auto unnormalized = make(parity::kind::even, -1);
+            CHECK(unnormalized.is_bottom());
+            CHECK_EQ(unnormalized, bounded_parity::bottom());
+
+            // the even parity of the bottom value does not leak into joins
+            auto odd = make(parity::kind::odd, 5);
+            CHECK_EQ(join(unnormalized, odd), odd);
+            CHECK_EQ(join(odd, unnormalized), odd);
+            CHECK_EQ(widen(unnormalized, odd), odd);
+
+            auto value = unnormalized;
+            CHECK_FALSE(value.join_with(bounded_parity::bottom()));
+            CHECK(value.get< parity >().is_bottom());
+            CHECK(value.join_with(odd));
+            CHECK_EQ(value, odd);
+
+            CHECK(domains::is_leq(unnormalized, odd));
+            CHECK_FALSE(domains::is_leq(odd, unnormalized));
+            CHECK(meet(odd, unnormalized).is_bottom());
+        }
+
+        TEST_CASE("reduce hooks are iterated until stable") {
+            reductions = 0;
+
+            // the bound drops to the odd 3, then no hook changes anything
+            auto value = make(parity::kind::odd, 9);
+            CHECK(value.meet_with(make(parity::kind::top, 4)));
+            CHECK_EQ(value.get< parity >().value, parity::kind::odd);
+            CHECK_EQ(value.get< chain >().value, 3);
+            CHECK_EQ(reductions, 4);
+
+            // the bound 0 makes the parity even, which conflicts with odd
+            auto zero = make(parity::kind::odd, 9);
+            CHECK(zero.meet_with(make(parity::kind::top, 0)));
+            CHECK(zero.is_bottom());
+
+            // no reduction without a change
+            reductions = 0;
+            auto fixed = make(parity::kind::even, 2);
+            CHECK_FALSE(fixed.meet_with(bounded_parity::top()));
+            CHECK_EQ(reductions, 0);
+        }
+
+        TEST_CASE("order is componentwise") {
+            auto small = make(parity::kind::even, 2);
+            auto large = make(parity::kind::top, 5);
+
+            CHECK(domains::is_leq(small, large));
+            CHECK_FALSE(domains::is_leq(large, small));
+            CHECK_FALSE(domains::is_leq(small, make(parity::kind::odd, 5)));
+            CHECK_FALSE(domains::is_leq(small, make(parity::kind::even, 1)));
+
+            CHECK(domains::is_leq(bounded_parity::bottom(), small));
+            CHECK(domains::is_leq(small, bounded_parity::top()));
+        }
+    }
+
+} // namespace mi::test
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+import miller.domains;
+
+namespace mi::test
+{
+    struct chain_calls {
+        static inline int in_place = 0;
+        static inline int by_value = 0;
+
+        static void reset() { in_place = by_value = 0; }
+    };
+
+    //
+    // Test lattice: the chain bottom < 0 < 1 < ... < top of integers, with
+    // join max and meet min. Calls of the lattice operations are counted in
+    // chain_calls; only with `in_place` the chain has the in-place members
+    // and its own order, otherwise the library falls back to the value forms.
+    //
+    template< bool in_place = false >
+    struct basic_chain {
+        static constexpr int bottom_value = -1;
+        static constexpr int top_value = std::numeric_limits< int >::max();
+
+        int value;
+
+        static constexpr domains::domain_info info() noexcept { return {}; }
+
+        static constexpr basic_chain top() noexcept { return { top_value }; }
+        static constexpr basic_chain bottom() noexcept { return { bottom_value }; }
+
+        constexpr bool is_top() const noexcept { return value == top_value; }
+        constexpr bool is_bottom() const noexcept { return value == bottom_value; }
+
+        constexpr bool operator==(const basic_chain &) const = default;
+
+        std::size_t hash() const noexcept { return std::size_t(value); }
+
+        bool join_with(const basic_chain &other) requires in_place {
+            ++chain_calls::in_place;
+            return update(std::max(value, other.value));
+        }
+
+        bool meet_with(const basic_chain &other) requires in_place {
+            ++chain_calls::in_place;
+            return update(std::min(value, other.value));
+        }
+
+        bool widen_with(const basic_chain &other) requires in_place {
+            ++chain_calls::in_place;
+            return update(other.value > value ? top_value : value);
+        }
+
+        bool leq(const basic_chain &other) const requires in_place {
+            ++chain_calls::in_place;
+            return value <= other.value;
+        }
+
+      private:
+        bool update(int next) {
+            bool changed = next != value;
+            value = next;
+            return changed;
+        }
+    };
+
+    template< bool in_place >
+    basic_chain< in_place > join(basic_chain< in_place > a, basic_chain< in_place > b) {
+        ++chain_calls::by_value;
+        return { std::max(a.value, b.value) };
+    }
+
+    template< bool in_place >
+    basic_chain< in_place > meet(basic_chain< in_place > a, basic_chain< in_place > b) {
+        ++chain_calls::by_value;
+        return { std::min(a.value, b.value) };
+    }
+
+    using chain = basic_chain<>;
+
+    static_assert(domains::domain_like< chain >);
+
+} // namespace mi::test
@@ -0,0 +1,65 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <doctest/doctest.h>
+
+import miller.trace;
+
+namespace mi::test
+{
+    std::string read_file(const std::filesystem::path &path) {
+        std::ifstream in(path);
+        return { std::istreambuf_iterator< char >(in), std::istreambuf_iterator< char >() };
+    }
+
+    TEST_SUITE("mi::trace") {
+
+        TEST_CASE("events are written as chrome trace json") {
+            auto path = std::filesystem::temp_directory_path() / "miller-test-trace.json";
+            std::filesystem::remove(path);
+
+            trace::disable();
+            CHECK( !trace::enabled() );
+            trace::enable(path.string());
+            CHECK( trace::enabled() );
+
+            {
+                auto span = trace::span("phase", "test", "items", 3);
+                trace::instant("step", "test");
+            }
+
+            trace::flush();
+            auto json = read_file(path);
+
+            CHECK( json.starts_with("{\"traceEvents\":[") );
+            CHECK( json.find("\"displayTimeUnit\":\"ms\"}") != std::string::npos );
+
+            auto span = json.find("{\"name\":\"phase\",\"cat\":\"test\",\"ph\":\"X\"");
+            REQUIRE( span != std::string::npos );
+            CHECK( json.find("\"dur\":", span) != std::string::npos );
+            CHECK( json.find("\"args\":{\"items\":3}", span) != std::string::npos );
+
+            auto instant = json.find("{\"name\":\"step\",\"cat\":\"test\",\"ph\":\"i\"");
+            REQUIRE( instant != std::string::npos );
+            CHECK( json.find("\"s\":\"t\"", instant) != std::string::npos );
+
+            // the instant is recorded before the span ends
+            CHECK( instant < span );
+
+            // flush drains the recorded events
+            trace::flush();
+            CHECK( read_file(path).find("\"name\"") == std::string::npos );
+
+            // a disabled trace neither records nor writes the file again
+            trace::disable();
+            CHECK( !trace::enabled() );
+            trace::instant("ignored", "test");
+            std::filesystem::remove(path);
+            trace::flush();
+            CHECK( !std::filesystem::exists(path) );
+        }
+    }
+
+} // namespace mi::test
@@ -0,0 +1,68 @@
+#include <vector>
+
+#include <doctest/doctest.h>
+
+import miller.util;
+
+namespace mi::test
+{
+    TEST_SUITE("mi::dense_bitset") {
+        TEST_CASE("set and test bits across words") {
+            dense_bitset bits(130);
+            CHECK(bits.none());
+
+            bits.set(3);
+            bits.set(129);
+
+            CHECK(bits.test(3));
+            CHECK(bits.test(129));
+            CHECK(!bits.test(64));
+            CHECK_EQ(bits.count(), 2);
+        }
+
+        TEST_CASE("full set does not leak unused bits") {
+            dense_bitset full(70, true);
+            CHECK_EQ(full.count(), 70);
+
+            dense_bitset empty(70);
+            empty.set_all();
+            CHECK_EQ(empty, full);
+        }
+
+        TEST_CASE("in-place operations report change") {
+            dense_bitset a(300), b(300);
+            b.set(0);
+            b.set(257);
+
+            CHECK(a.union_with(b));
+            CHECK(!a.union_with(b));
+            CHECK_EQ(a, b);
+
+            dense_bitset c(300);
+            c.set(257);
+            CHECK(a.intersect_with(c));
+            CHECK(!a.intersect_with(c));
+            CHECK_EQ(a, c);
+
+            CHECK(a.subtract(c));
+            CHECK(!a.subtract(c));
+            CHECK(a.none());
+        }
+
+        TEST_CASE("iterate set bits") {
+            dense_bitset bits(200);
+            for (auto idx : { 1, 63, 64, 199 }) {
+                bits.set(idx);
+            }
+
+            std::vector< std::size_t > seen;
+            bits.for_each([&] (auto idx) { seen.push_back(idx); });
+            CHECK_EQ(seen, std::vector< std::size_t >{ 1, 63, 64, 199 });
+
+            CHECK_EQ(bits.find_next(2), 63);
+            CHECK_EQ(bits.find_next(65), 199);
+            CHECK_EQ(bits.find_next(200), 200);
+        }
+    } // test suite dense_bitset
+
+} // namespace mi::test
@@ -0,0 +1,56 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+import miller.util;
+
+namespace mi::test
+{
+    TEST_SUITE("mi::hash_cons_table") {
+        TEST_CASE("equal values share the canonical copy") {
+            hash_cons_table< std::string > table;
+
+            auto a = table.intern(std::string("x + 1"));
+            auto b = table.intern(std::string("x + 1"));
+            auto c = table.intern(std::string("y"));
+
+            CHECK_EQ(a, b);
+            CHECK_NE(a, c);
+            CHECK_EQ(*a, "x + 1");
+            CHECK_EQ(table.size(), 2);
+        }
+
+        TEST_CASE("concurrent interning") {
+            hash_cons_table< int > table;
+
+            std::vector< std::jthread > workers;
+            for (int t = 0; t < 4; ++t) {
+                workers.emplace_back([&] {
+                    for (int i = 0; i < 1000; ++i) {
+                        table.intern(i % 100);
+                    }
+                });
+            }
+            workers.clear();
+
+            CHECK_EQ(table.size(), 100);
+        }
+
+        TEST_CASE("memoized operations keyed by canonical operands") {
+            hash_cons_table< int > table;
+            hash_cons_memo< int > memo;
+
+            auto one = table.intern(1);
+            auto two = table.intern(2);
+
+            CHECK(!memo.find(0, one, two));
+
+            memo.insert(0, one, two, table.intern(3));
+            CHECK_EQ(*memo.find(0, one, two), table.intern(3));
+            CHECK(!memo.find(1, one, two));
+        }
+    }
+
+} // namespace mi::test
@@ -9,6 +9,7 @@
 #include <coroutine>
 
 import miller.config;
+import miller.trace;
 
 namespace mi {
 
@@ -22,6 +23,9 @@ namespace mi {
             .default_value(false)
             .implicit_value(true);
 
+        config.add_argument("--trace")
+            .help("write a chrome trace of analysis phases to the given file.");
+
         return config;
     }
 
@@ -34,6 +38,10 @@ int main(int argc, char* argv[]) try {
     spdlog::cfg::load_env_levels();
     spdlog::cfg::load_argv_levels(argc, argv);
 
+    if (auto path = opts.present("--trace")) {
+        mi::trace::enable(*path);
+    }
+
 } catch (const std::runtime_error& err) {
     fmt::print(stderr, "{}\n", err.what());
     return 1;
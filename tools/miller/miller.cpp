@@ -1,7 +1,30 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <argparse/argparse.hpp>
-#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/MLIRContext.h>
+#include <mlir/Parser/Parser.h>
 
+import miller.analysis;
 import miller.config;
+import miller.dialects;
+import miller.domains;
+import miller.program;
+import miller.trace;
 
 namespace mi {
 
@@ -12,11 +35,13 @@ namespace mi {
 
         config.add_argument("program")
             .required()
-            .help("mlir program to process");
+            .nargs(argparse::nargs_pattern::at_least_one)
+            .help("mlir programs to process, @file reads a list of programs, one per line");
 
         config.add_argument("--verbose")
             .default_value(false)
-            .implicit_value(true);
+            .implicit_value(true)
+            .help("print the analysed modules and their invariants.");
 
 
         config.add_argument("-o", "--output")
@@ -24,9 +49,190 @@ namespace mi {
             .required()
             .help("specify the output file.");
 
+        config.add_argument("-j", "--jobs")
+            .default_value(std::max(1u, std::thread::hardware_concurrency()))
+            .scan< 'u', unsigned >()
+            .help("number of programs analysed in parallel.");
+
+        config.add_argument("--ordered")
+            .default_value(false)
+            .implicit_value(true)
+            .help("emit results in the order of inputs instead of completion.");
+
+        config.add_argument("--trace")
+            .help("write a chrome trace of analysis phases to the given file.");
+
         return config;
     }
 
+    // expands response files given as @path into the programs they list
+    std::vector< std::string > expand_inputs(const std::vector< std::string > &args) {
+        std::vector< std::string > inputs;
+        for (const auto &arg : args) {
+            if (!arg.starts_with('@')) {
+                inputs.push_back(arg);
+                continue;
+            }
+
+            std::ifstream list(arg.substr(1));
+            if (!list) {
+                throw std::runtime_error(fmt::format("cannot open response file: {}", arg.substr(1)));
+            }
+
+            for (std::string line; std::getline(list, line); ) {
+                // response files written on windows end lines with \r\n
+                if (line.ends_with('\r')) {
+                    line.pop_back();
+                }
+
+                if (!line.empty()) {
+                    inputs.push_back(std::move(line));
+                }
+            }
+        }
+
+        return inputs;
+    }
+
+    //
+    // Parses an mlir module; operations of dialects that are not registered
+    // are kept in their generic form, the analysis needs only the structure
+    // of regions and blocks.
+    //
+    mlir::OwningOpRef< mlir::ModuleOp > parse_module(const std::string &path, mlir::MLIRContext &ctx) {
+        auto span = trace::span("parse_module", "miller");
+
+        auto mod = mlir::parseSourceFile< mlir::ModuleOp >(path, mlir::ParserConfig(&ctx));
+        if (!mod) {
+            throw std::runtime_error(fmt::format("cannot parse mlir module: {}", path));
+        }
+
+        return mod;
+    }
+
+    struct file_result {
+        std::string output;
+        bool failed = false;
+    };
+
+    file_result analyse_file(const std::string &path, mlir::MLIRContext &ctx, bool verbose) {
+        auto span = trace::span("analyse_file", "miller");
+        auto start = std::chrono::steady_clock::now();
+
+        file_result result;
+        try {
+            auto mod = parse_module(path, ctx);
+
+            // the module is analysed in place through views of its operations
+            dyn::operation_view root{ mod->getOperation() };
+            auto graph = dfa::build_flow_graph(root);
+
+            // operations of unknown dialects carry no semantics, the engine
+            // alone finds the program points without a path from the entry
+            auto transfer = [] (const dfa::flow_item &, domains::reachability &) {};
+            auto invariants = analysis::forward_fixpoint< domains::reachability >(
+                graph, transfer
+            ).materialize();
+
+            auto unreachable = std::ranges::count_if(invariants.pre, [] (const auto &entry) {
+                return entry.second.is_bottom();
+            });
+
+            if (verbose) {
+                auto format_span = trace::span("format_result", "miller");
+                fmt::memory_buffer buffer;
+                root.format_to(fmt::appender(buffer));
+                fmt::format_to(fmt::appender(buffer), "{}", invariants);
+                result.output = fmt::to_string(buffer);
+            }
+
+            std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+            result.output += fmt::format("// {}: {} labels, {} unreachable, {:.3f} ms\n",
+                path, invariants.pre.size(), unreachable, elapsed.count()
+            );
+        } catch (const std::exception &err) {
+            // reported per file, an exception escaping a worker would end the batch
+            result.output = fmt::format("// {}: error: {}\n", path, err.what());
+            result.failed = true;
+        }
+
+        return result;
+    }
+
+    struct batch_options {
+        unsigned jobs;
+        bool ordered;
+        bool verbose;
+    };
+
+    //
+    // Analyses all inputs on a pool of workers in one process.
+    //
+    // Workers share the mlir context, i.e. its uniqued identifiers, types
+    // and attributes and the arenas they are allocated in. Results are
+    // streamed to `out` as files complete, or in the order of inputs if
+    // requested. Returns the number of failed files.
+    //
+    std::size_t analyse_batch(
+        const std::vector< std::string > &inputs, mlir::MLIRContext &ctx,
+        const batch_options &opts, std::FILE *out
+    ) {
+        std::atomic< std::size_t > next = 0;
+
+        std::mutex output_mutex;
+        std::vector< std::optional< file_result > > completed(inputs.size());
+        std::size_t emitted = 0;
+        std::size_t failed = 0;
+
+        // writes the result of a file and returns whether the file passed;
+        // a result that cannot be written fails the file instead of throwing,
+        // an exception escaping a worker would end the batch
+        auto write = [&] (const file_result &result) {
+            try {
+                fmt::print(out, "{}", result.output);
+            } catch (const std::exception &err) {
+                std::fprintf(stderr, "cannot write result: %s\n", err.what());
+                return false;
+            }
+            return !result.failed;
+        };
+
+        auto emit = [&] (std::size_t idx, file_result &&result) {
+            std::scoped_lock lock(output_mutex);
+            auto span = trace::span("write_output", "miller");
+
+            if (!opts.ordered) {
+                failed += !write(result);
+            } else {
+                completed[idx] = std::move(result);
+                for (; emitted < completed.size() && completed[emitted]; ++emitted) {
+                    failed += !write(*completed[emitted]);
+                    completed[emitted].reset();
+                }
+            }
+
+            std::fflush(out);
+        };
+
+        auto worker = [&] {
+            for (auto idx = next++; idx < inputs.size(); idx = next++) {
+                emit(idx, analyse_file(inputs[idx], ctx, opts.verbose));
+            }
+        };
+
+        {
+            auto count = std::min< std::size_t >(opts.jobs, inputs.size());
+
+            std::vector< std::jthread > workers;
+            for (std::size_t i = 1; i < count; ++i) {
+                workers.emplace_back(worker);
+            }
+            worker();
+        }
+
+        return failed;
+    }
+
 } // namespace mi
 
 
@@ -34,6 +240,39 @@ int main(int argc, char* argv[]) try {
     auto opts = mi::get_options_config();
     opts.parse_args(argc, argv);
 
+    if (auto path = opts.present("--trace")) {
+        mi::trace::enable(*path);
+    }
+
+    auto inputs = mi::expand_inputs(opts.get< std::vector< std::string > >("program"));
+
+    auto output = opts.get< std::string >("--output");
+    auto out = output == "-" ? stdout : std::fopen(output.c_str(), "w");
+    if (!out) {
+        throw std::runtime_error(fmt::format("cannot open output file: {}", output));
+    }
+
+    mlir::MLIRContext ctx;
+    ctx.allowUnregisteredDialects();
+
+    auto start = std::chrono::steady_clock::now();
+    auto failed = mi::analyse_batch(inputs, ctx, {
+        .jobs = std::max(1u, opts.get< unsigned >("--jobs")),
+        .ordered = opts.get< bool >("--ordered"),
+        .verbose = opts.get< bool >("--verbose")
+    }, out);
+
+    if (inputs.size() > 1) {
+        std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+        fmt::print(out, "// {} files, {} failed, {:.3f} ms\n", inputs.size(), failed, elapsed.count());
+    }
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    return failed ? 1 : 0;
+
 } catch (const std::runtime_error& err) {
     fmt::print(stderr, "{}\n", err.what());
     return 1;